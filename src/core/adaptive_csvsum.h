@@ -0,0 +1,228 @@
+#pragma once
+
+#include "full_csvsum.h"
+#include "sample_csvsum.h"
+#include <climits>
+#include <cmath>
+#include <memory>
+
+namespace csvsum
+{
+    struct SummaryPlan
+    {
+        // the throughput probe already read the entire file
+        bool complete = false;
+        bool sample = false;
+        int no_samples = 0;
+        // estimated time of a full scan in ms, the time it took if the probe read the entire file
+        double est_full_ms = 0;
+        // time spent on measuring the throughput in ms
+        double planning_ms = 0;
+    };
+
+    // Picks between a full scan and sampling such that the summary is computed within a time budget. The throughput
+    // of a full scan is measured by scanning increasingly large prefixes of the file. If the rest of the full scan does
+    // not fit into the budget, the cost per sample is measured with a small pilot sample and the sample size is chosen
+    // to use up the remaining budget.
+    // The work done while planning is not thrown away: a full scan continues where the probes stopped and the pilot
+    // sample is grown into the final sample.
+    class AdaptiveCSVSummarizer
+    {
+    private:
+        std::string path;
+        bool header;
+        char sep;
+        char line_break;
+        char escape_char;
+        char quotechar;
+        int no_most_freq;
+        int skip_value;
+        int time_budget;
+        uint64_t seed;
+        int no_threads;
+
+        // share of the budget which may be spent on measuring the throughput of a full scan
+        static constexpr double probe_frac = 0.05;
+        static constexpr long long min_probe_bytes = 1 << 16;
+        static constexpr int min_samples = 100;
+        // The cost per byte of a full scan grows with the number of distinct values, since the accumulators outgrow
+        // the caches (by about 1.5x between the first megabytes and the whole file for a column of unique ids).
+        // Hence, the extrapolated time of the rest of the scan is padded.
+        static constexpr double full_scan_margin = 1.5;
+
+        // summarizers of the last plan, which are continued by obtain_stats() and summarize()
+        std::unique_ptr<FullCSVSummarizer> scanner;
+        std::unique_ptr<SampleCSVSummarizer> sampler;
+
+        static double elapsed_ms(std::chrono::steady_clock::time_point begin)
+        {
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+        }
+
+        // Estimate the time of scanning the rest of the file from the cost per byte of the last two probes. The
+        // larger one is used, so that a single probe which happened to be fast does not lead to an underestimate.
+        static double extrapolate_ms(double prev_rate, double rate, long long probe_bytes, long long file_size)
+        {
+            return full_scan_margin * std::max(prev_rate, rate) * (file_size - probe_bytes);
+        }
+
+    public:
+        AdaptiveCSVSummarizer(std::string path, bool header, char sep, char line_break, char escape_char, char quotechar, int no_most_freq, int skip_value, int time_budget, uint64_t seed = 0, int no_threads = 1)
+            : path(path), header(header), sep(sep), line_break(line_break), escape_char(escape_char), quotechar(quotechar), no_most_freq(no_most_freq), skip_value(skip_value), time_budget(time_budget), seed(seed), no_threads(no_threads)
+        {
+        }
+
+        AdaptiveCSVSummarizer(std::string path, bool header, char sep, int time_budget) : AdaptiveCSVSummarizer(path, header, sep, '\n', '\\', '\0', 3, 100, time_budget)
+        {
+        }
+
+        SummaryPlan plan(bool verbose)
+        {
+            SummaryPlan plan;
+            auto begin = std::chrono::steady_clock::now();
+            scanner.reset();
+            sampler.reset();
+
+            std::ifstream in(path);
+            if (in.fail())
+            {
+                // let the full scan report the error
+                return plan;
+            }
+            in.seekg(0, in.end);
+            long long file_size = in.tellg();
+            in.close();
+
+            // Scan increasingly large prefixes of the file until the probe is representative, i.e., it took a
+            // noticeable part of the budget or covered a noticeable part of the file. Each probe continues the scan
+            // of the previous one.
+            scanner.reset(new FullCSVSummarizer(path, header, sep, line_break, escape_char, quotechar, no_most_freq));
+            long long probe_bytes = min_probe_bytes;
+            long long prev_bytes = 0;
+            double prev_rate = 0;
+            double rate = 0;
+            while (true)
+            {
+                auto probe_begin = std::chrono::steady_clock::now();
+                if (scanner->scan(probe_bytes >= file_size ? -1 : probe_bytes))
+                {
+                    plan.complete = true;
+                    plan.est_full_ms = elapsed_ms(begin);
+                    plan.planning_ms = plan.est_full_ms;
+                    return plan;
+                }
+                prev_rate = rate;
+                rate = elapsed_ms(probe_begin) / (probe_bytes - prev_bytes);
+                prev_bytes = probe_bytes;
+
+                if (elapsed_ms(begin) >= probe_frac * time_budget || probe_bytes >= probe_frac * file_size)
+                    break;
+                probe_bytes *= 2;
+            }
+            double rest_ms = extrapolate_ms(prev_rate, rate, probe_bytes, file_size);
+            plan.est_full_ms = elapsed_ms(begin) + rest_ms;
+
+            double remaining_ms = time_budget - elapsed_ms(begin);
+            if (rest_ms <= remaining_ms)
+            {
+                plan.planning_ms = elapsed_ms(begin);
+                return plan;
+            }
+            if (quotechar != '\0')
+            {
+                std::cerr << "Quotechars are not supported for sampling mode. Falling back to a full scan which will likely exceed the time budget." << std::endl;
+                plan.planning_ms = elapsed_ms(begin);
+                return plan;
+            }
+            // the prefix is not a sample of the file
+            scanner.reset();
+
+            // measure the cost per sample with a pilot sample of complete chunks which keeps all threads busy
+            int pilot_chunks = std::max((min_samples + SampleCSVSummarizer::chunk_size - 1) / SampleCSVSummarizer::chunk_size, no_threads);
+            int pilot_samples = pilot_chunks * SampleCSVSummarizer::chunk_size;
+            auto pilot_begin = std::chrono::steady_clock::now();
+            vector<std::string> col_names;
+            long long no_rows;
+            sampler.reset(new SampleCSVSummarizer(path, header, sep, line_break, escape_char, no_most_freq, pilot_samples, skip_value, seed, no_threads));
+            sampler->obtain_stats(false, col_names, no_rows);
+            double sample_ms = elapsed_ms(pilot_begin) / pilot_samples;
+
+            // the pilot sample is part of the final sample
+            remaining_ms = time_budget - elapsed_ms(begin);
+            plan.sample = true;
+            plan.no_samples = pilot_samples;
+            if (sample_ms > 0 && remaining_ms > 0)
+            {
+                plan.no_samples += static_cast<int>(std::min<double>(remaining_ms / sample_ms, INT_MAX - pilot_samples));
+            }
+            plan.planning_ms = elapsed_ms(begin);
+
+            if (verbose)
+                std::cout << "Time per sample = " << sample_ms << "[ms]" << std::endl;
+
+            return plan;
+        }
+
+        void summarize(bool verbose)
+        {
+            auto begin = std::chrono::steady_clock::now();
+            SummaryPlan p = plan(verbose);
+            if (verbose)
+                std::cout << "Time to plan = " << std::round(p.planning_ms) << "[ms]" << std::endl;
+
+            if (p.sample)
+            {
+                std::cout << "Strategy: sample (full scan estimated at " << std::round(p.est_full_ms) << "[ms], budget " << time_budget << "[ms])" << std::endl;
+                sampler->grow_sample(p.no_samples);
+                sampler->summarize(verbose);
+
+                // worst case margin of error of the estimated value frequencies (95% confidence), based on the
+                // effective sample size since rows are weighted by their inverse size
+                double ess = sampler->effective_sample_size();
+                double margin = 1.96 * std::sqrt(0.25 / ess);
+                std::cout << "Accuracy: value frequencies within +-" << std::round(margin * 10000) / 100 << "% (95% confidence, effective sample size " << std::round(ess) << ")" << std::endl;
+            }
+            else
+            {
+                if (p.complete)
+                    std::cout << "Strategy: full scan (took " << std::round(p.est_full_ms) << "[ms] while measuring the throughput, budget " << time_budget << "[ms])" << std::endl;
+                else
+                    std::cout << "Strategy: full scan (estimated at " << std::round(p.est_full_ms) << "[ms], budget " << time_budget << "[ms])" << std::endl;
+                std::cout << "Accuracy: exact" << std::endl;
+
+                vector<std::string> col_names;
+                long long no_rows;
+                vector<CellStats> stats = obtain_stats(verbose, p, col_names, no_rows);
+                if (stats.size() > 0)
+                {
+                    std::cout << "Total no rows: " << no_rows << std::endl;
+                    CSVSummarizer::print_summary(stats, col_names);
+                }
+            }
+
+            std::cout << "Total time = " << std::round(elapsed_ms(begin)) << "[ms]" << std::endl;
+        }
+
+        // Compute the statistics according to a plan returned by the last call of plan()
+        vector<CellStats> obtain_stats(bool verbose, const SummaryPlan &plan, vector<std::string> &col_names, long long &no_rows)
+        {
+            if (plan.sample)
+            {
+                sampler->grow_sample(plan.no_samples);
+                return sampler->obtain_stats(verbose, col_names, no_rows);
+            }
+            if (!scanner)
+            {
+                FullCSVSummarizer full(path, header, sep, line_break, escape_char, quotechar, no_most_freq);
+                return full.obtain_stats(verbose, col_names, no_rows);
+            }
+
+            // continue the scan of the probes
+            auto begin = std::chrono::steady_clock::now();
+            scanner->scan(-1);
+            if (verbose)
+                std::cout << "Time to read file = " << std::round(elapsed_ms(begin)) << "[ms]" << std::endl;
+            return scanner->scanned_stats(col_names, no_rows);
+        }
+    };
+}
@@ -0,0 +1,491 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using std::vector;
+
+namespace csvsum
+{
+    enum class ColumnType
+    {
+        EMPTY,
+        BOOL,
+        INT,
+        DOUBLE,
+        DATE,
+        TIMESTAMP,
+        STRING
+    };
+
+    inline const char *type_name(ColumnType type)
+    {
+        switch (type)
+        {
+        case ColumnType::BOOL:
+            return "bool";
+        case ColumnType::INT:
+            return "int";
+        case ColumnType::DOUBLE:
+            return "double";
+        case ColumnType::DATE:
+            return "date";
+        case ColumnType::TIMESTAMP:
+            return "timestamp";
+        case ColumnType::STRING:
+            return "string";
+        default:
+            return "";
+        }
+    }
+
+    // Days since 1970-01-01 of a date in the proleptic gregorian calendar (see http://howardhinnant.github.io/date_algorithms.html)
+    inline long long days_from_civil(long long y, unsigned m, unsigned d)
+    {
+        y -= m <= 2;
+        long long era = (y >= 0 ? y : y - 399) / 400;
+        unsigned yoe = static_cast<unsigned>(y - era * 400);
+        unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+        unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + static_cast<long long>(doe) - 719468;
+    }
+
+    inline void civil_from_days(long long z, long long &y, unsigned &m, unsigned &d)
+    {
+        z += 719468;
+        long long era = (z >= 0 ? z : z - 146096) / 146097;
+        unsigned doe = static_cast<unsigned>(z - era * 146097);
+        unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        unsigned mp = (5 * doy + 2) / 153;
+        d = doy - (153 * mp + 2) / 5 + 1;
+        m = mp < 10 ? mp + 3 : mp - 9;
+        y = static_cast<long long>(yoe) + era * 400 + (m <= 2);
+    }
+
+    // Format seconds since epoch (UTC) as ISO date, optionally including the time of day
+    inline std::string format_time(double secs, bool with_time)
+    {
+        long long s = static_cast<long long>(secs);
+        if (s > secs)
+            s--;
+        long long days = (s >= 0 ? s : s - 86399) / 86400;
+        long long sod = s - days * 86400;
+
+        long long y;
+        unsigned m, d;
+        civil_from_days(days, y, m, d);
+
+        char buf[64];
+        if (with_time)
+        {
+            std::snprintf(buf, sizeof(buf), "%04lld-%02u-%02u %02lld:%02lld:%02lld", y, m, d, sod / 3600, sod / 60 % 60, sod % 60);
+        }
+        else
+        {
+            std::snprintf(buf, sizeof(buf), "%04lld-%02u-%02u", y, m, d);
+        }
+        return buf;
+    }
+
+    // Collects the value counts of a single column. In addition, values are parsed and aggregated natively. Each
+    // distinct value is only parsed once, when it is first inserted into the counts, and its parsed value is reused for
+    // later occurrences. The type of the column is sniffed from the first non-null value, whose parser is tried first
+    // for new values. It is only demoted (int to double, date to timestamp, anything else to string) if later values do
+    // not match. Values of other types are still aggregated in their own accumulator, so no counts are lost when a
+    // column turns out to be mixed.
+    class ColumnAccumulator
+    {
+    public:
+        struct ValueCount
+        {
+            double weight = 0;
+            // type of the value, EMPTY for nulls
+            ColumnType type = ColumnType::EMPTY;
+            // numeric value, 0/1 for bools and seconds since epoch (UTC) for dates and timestamps
+            double value = 0;
+            // exact value of ints, which are not representable as doubles beyond 2^53
+            long long int_value = 0;
+        };
+
+        ColumnType type = ColumnType::EMPTY;
+        std::unordered_map<std::string, ValueCount> counts;
+
+        // Number of most frequent values which are tracked while adding values, 0 if they are only determined when
+        // the statistics are computed. Since weights only grow, the tracked values are exact and summarizing does not
+        // have to visit all distinct values.
+        int top_k = 0;
+        // tracked values with their weight, most frequent first
+        vector<std::pair<std::string, double>> top;
+
+        double total_weight = 0;
+        double null_weight = 0;
+
+        double num_weight = 0;
+        double num_sum = 0;
+        double num_min = std::numeric_limits<double>::max();
+        double num_max = std::numeric_limits<double>::lowest();
+        long long int_min = std::numeric_limits<long long>::max();
+        long long int_max = std::numeric_limits<long long>::min();
+
+        double bool_weight = 0;
+        double true_weight = 0;
+
+        // seconds since epoch (UTC)
+        double time_weight = 0;
+        double time_min = std::numeric_limits<double>::max();
+        double time_max = std::numeric_limits<double>::lowest();
+
+        void add(const std::string &val, double w)
+        {
+            auto it = counts.find(val);
+            if (it == counts.end())
+            {
+                ValueCount vc;
+                vc.type = parse(val, vc);
+                it = counts.emplace(val, vc).first;
+            }
+            it->second.weight += w;
+            aggregate(it->second, w);
+            if (top_k > 0)
+                update_top(it->first, it->second.weight);
+        }
+
+        // Add the values of another accumulator of the same column
+        void merge(const ColumnAccumulator &other)
+        {
+            for (auto &value_count : other.counts)
+            {
+                auto it = counts.find(value_count.first);
+                if (it == counts.end())
+                {
+                    counts.emplace(value_count.first, value_count.second);
+                }
+                else
+                {
+                    it->second.weight += value_count.second.weight;
+                }
+            }
+
+            type = merge_types(type, other.type);
+            total_weight += other.total_weight;
+            null_weight += other.null_weight;
+            num_weight += other.num_weight;
+            num_sum += other.num_sum;
+            num_min = std::min(num_min, other.num_min);
+            num_max = std::max(num_max, other.num_max);
+            int_min = std::min(int_min, other.int_min);
+            int_max = std::max(int_max, other.int_max);
+            bool_weight += other.bool_weight;
+            true_weight += other.true_weight;
+            time_weight += other.time_weight;
+            time_min = std::min(time_min, other.time_min);
+            time_max = std::max(time_max, other.time_max);
+
+            if (top_k > 0)
+            {
+                top.clear();
+                for (auto &value_count : counts)
+                    update_top(value_count.first, value_count.second.weight);
+            }
+        }
+
+    private:
+        // order of the most frequent values, ties are broken by the value
+        static bool more_frequent(const std::string &val, double weight, const std::pair<std::string, double> &other)
+        {
+            return weight > other.second || (weight == other.second && val < other.first);
+        }
+
+        // A value can only move up when its weight grows, hence it either is already tracked or replaces the least
+        // frequent tracked value.
+        void update_top(const std::string &val, double weight)
+        {
+            size_t pos = 0;
+            while (pos < top.size() && top[pos].first != val)
+                pos++;
+            if (pos < top.size())
+            {
+                top[pos].second = weight;
+            }
+            else if (top.size() < static_cast<size_t>(top_k))
+            {
+                top.emplace_back(val, weight);
+            }
+            else if (more_frequent(val, weight, top.back()))
+            {
+                top.back() = std::make_pair(val, weight);
+                pos = top.size() - 1;
+            }
+            else
+            {
+                return;
+            }
+
+            for (; pos > 0 && more_frequent(top[pos].first, top[pos].second, top[pos - 1]); pos--)
+                std::swap(top[pos], top[pos - 1]);
+        }
+
+        static ColumnType merge_types(ColumnType col_type, ColumnType val_type)
+        {
+            if (val_type == ColumnType::EMPTY)
+                return col_type;
+            if (col_type == ColumnType::EMPTY || col_type == val_type)
+                return val_type;
+            if ((col_type == ColumnType::INT || col_type == ColumnType::DOUBLE) && (val_type == ColumnType::INT || val_type == ColumnType::DOUBLE))
+                return ColumnType::DOUBLE;
+            if ((col_type == ColumnType::DATE || col_type == ColumnType::TIMESTAMP) && (val_type == ColumnType::DATE || val_type == ColumnType::TIMESTAMP))
+                return ColumnType::TIMESTAMP;
+            return ColumnType::STRING;
+        }
+
+        // try the type of the column first, the remaining types are only checked if the value does not match
+        ColumnType parse(const std::string &val, ValueCount &vc) const
+        {
+            double &value = vc.value;
+            if (val.empty())
+                return ColumnType::EMPTY;
+
+            ColumnType val_type = ColumnType::STRING;
+            switch (type)
+            {
+            case ColumnType::BOOL:
+                val_type = parse_bool(val, value);
+                break;
+            case ColumnType::INT:
+            case ColumnType::DOUBLE:
+                val_type = parse_numeric(val, value, vc.int_value);
+                break;
+            case ColumnType::DATE:
+            case ColumnType::TIMESTAMP:
+                val_type = parse_temporal(val, value);
+                break;
+            default:
+                break;
+            }
+
+            if (val_type == ColumnType::STRING)
+                val_type = parse_bool(val, value);
+            if (val_type == ColumnType::STRING)
+                val_type = parse_numeric(val, value, vc.int_value);
+            if (val_type == ColumnType::STRING)
+                val_type = parse_temporal(val, value);
+            return val_type;
+        }
+
+        void aggregate(const ValueCount &vc, double w)
+        {
+            total_weight += w;
+            switch (vc.type)
+            {
+            case ColumnType::EMPTY:
+                null_weight += w;
+                break;
+            case ColumnType::BOOL:
+                bool_weight += w;
+                true_weight += w * vc.value;
+                break;
+            case ColumnType::INT:
+                int_min = std::min(int_min, vc.int_value);
+                int_max = std::max(int_max, vc.int_value);
+                // fall through
+            case ColumnType::DOUBLE:
+                num_weight += w;
+                num_sum += w * vc.value;
+                num_min = std::min(num_min, vc.value);
+                num_max = std::max(num_max, vc.value);
+                break;
+            case ColumnType::DATE:
+            case ColumnType::TIMESTAMP:
+                time_weight += w;
+                time_min = std::min(time_min, vc.value);
+                time_max = std::max(time_max, vc.value);
+                break;
+            default:
+                break;
+            }
+            type = merge_types(type, vc.type);
+        }
+
+        static bool equals_ignore_case(const std::string &val, const char *lower)
+        {
+            size_t i = 0;
+            for (; lower[i] != '\0'; i++)
+            {
+                if (i >= val.size() || std::tolower(static_cast<unsigned char>(val[i])) != lower[i])
+                    return false;
+            }
+            return i == val.size();
+        }
+
+        static ColumnType parse_bool(const std::string &val, double &value)
+        {
+            bool is_true = equals_ignore_case(val, "true");
+            if (!is_true && !equals_ignore_case(val, "false"))
+                return ColumnType::STRING;
+
+            value = is_true ? 1 : 0;
+            return ColumnType::BOOL;
+        }
+
+        // from_chars neither skips whitespace nor accepts a leading plus or hex numbers and does not depend on the locale
+        static ColumnType parse_numeric(const std::string &val, double &value, long long &int_value)
+        {
+            const char *first = val.data();
+            const char *last = first + val.size();
+
+            long long ival;
+            auto res = std::from_chars(first, last, ival);
+            if (res.ec == std::errc() && res.ptr == last)
+            {
+                int_value = ival;
+                value = static_cast<double>(ival);
+                return ColumnType::INT;
+            }
+
+            double fval;
+            res = std::from_chars(first, last, fval);
+            if (res.ec != std::errc() || res.ptr != last)
+                return ColumnType::STRING;
+
+            value = fval;
+            return ColumnType::DOUBLE;
+        }
+
+        static bool read_digits(const char *&p, const char *last, int n, int &out)
+        {
+            if (last - p < n)
+                return false;
+            out = 0;
+            for (int i = 0; i < n; i++, p++)
+            {
+                if (*p < '0' || *p > '9')
+                    return false;
+                out = out * 10 + (*p - '0');
+            }
+            return true;
+        }
+
+        // Parses ISO 8601 dates (YYYY-MM-DD) and timestamps (YYYY-MM-DD[T ]HH:MM[:SS[.fff]][Z|+HH:MM|-HH:MM])
+        static ColumnType parse_temporal(const std::string &val, double &value)
+        {
+            const char *p = val.data();
+            const char *last = p + val.size();
+            int y, mo, d, h = 0, mi = 0, s = 0, oh = 0, om = 0;
+            double frac = 0;
+
+            if (!read_digits(p, last, 4, y) || p == last || *p++ != '-' || !read_digits(p, last, 2, mo) || p == last || *p++ != '-' || !read_digits(p, last, 2, d))
+                return ColumnType::STRING;
+
+            static const int month_days[] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+            bool leap = (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+            if (mo < 1 || mo > 12 || d < 1 || d > month_days[mo - 1] || (mo == 2 && d == 29 && !leap))
+                return ColumnType::STRING;
+
+            ColumnType val_type = ColumnType::DATE;
+            if (p != last)
+            {
+                if ((*p != 'T' && *p != ' ') || !read_digits(++p, last, 2, h) || p == last || *p++ != ':' || !read_digits(p, last, 2, mi))
+                    return ColumnType::STRING;
+                if (p != last && *p == ':')
+                {
+                    if (!read_digits(++p, last, 2, s))
+                        return ColumnType::STRING;
+                    if (p != last && *p == '.')
+                    {
+                        double scale = 0.1;
+                        for (p++; p != last && *p >= '0' && *p <= '9'; p++, scale /= 10)
+                            frac += (*p - '0') * scale;
+                    }
+                }
+                if (p != last && *p == 'Z')
+                {
+                    p++;
+                }
+                else if (p != last && (*p == '+' || *p == '-'))
+                {
+                    int sign = *p == '-' ? -1 : 1;
+                    if (!read_digits(++p, last, 2, oh))
+                        return ColumnType::STRING;
+                    if (p != last && *p == ':')
+                        p++;
+                    if (!read_digits(p, last, 2, om))
+                        return ColumnType::STRING;
+                    oh *= sign;
+                    om *= sign;
+                }
+                if (p != last || h > 23 || mi > 59 || s > 60 || oh > 23 || oh < -23 || om > 59 || om < -59)
+                    return ColumnType::STRING;
+                val_type = ColumnType::TIMESTAMP;
+            }
+
+            value = days_from_civil(y, mo, d) * 86400.0 + (h - oh) * 3600 + (mi - om) * 60 + s + frac;
+            return val_type;
+        }
+    };
+
+    // The columns of a csv file. Rows are added as soon as they are parsed. If has_header is set, the first row which
+    // is added defines the column names. If top_k is set, the columns track their top_k most frequent values.
+    struct ColumnSet
+    {
+        vector<ColumnAccumulator> columns;
+        vector<std::string> col_names;
+        bool has_header;
+        long long no_rows = 0;
+        int top_k;
+
+        explicit ColumnSet(bool has_header = false, int top_k = 0) : has_header(has_header), top_k(top_k)
+        {
+        }
+
+        void resize(size_t no_columns)
+        {
+            size_t old_size = columns.size();
+            columns.resize(no_columns);
+            for (size_t j = old_size; j < no_columns; j++)
+            {
+                columns[j].top_k = top_k;
+            }
+        }
+
+        // add the first no_cells cells of a row
+        void add_row(const vector<std::string> &cells, size_t no_cells, double w)
+        {
+            if (has_header)
+            {
+                col_names.assign(cells.begin(), cells.begin() + no_cells);
+                has_header = false;
+                return;
+            }
+
+            if (columns.size() < no_cells)
+            {
+                resize(no_cells);
+            }
+            for (size_t j = 0; j < no_cells; j++)
+            {
+                columns[j].add(cells[j], w);
+            }
+            no_rows++;
+        }
+
+        void merge(const ColumnSet &other)
+        {
+            if (columns.size() < other.columns.size())
+            {
+                resize(other.columns.size());
+            }
+            for (size_t j = 0; j < other.columns.size(); j++)
+            {
+                columns[j].merge(other.columns[j]);
+            }
+            no_rows += other.no_rows;
+        }
+    };
+}
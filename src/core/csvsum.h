@@ -1,4 +1,6 @@
 #pragma once
 
 #include "full_csvsum.h"
+#include "follow_csvsum.h"
 #include "sample_csvsum.h"
+#include "adaptive_csvsum.h"
@@ -1,7 +1,7 @@
 #pragma once
 
+#include "column_accumulator.h"
 #include "fort.hpp"
-#include <boost/lexical_cast.hpp>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -14,14 +14,40 @@ using std::vector;
 
 namespace csvsum
 {
+    // State of the row which is currently parsed. The cell buffers are reused for the following rows.
+    struct RowParser
+    {
+        bool escaped = false;
+        bool quoted = false;
+        vector<std::string> cells = vector<std::string>(1);
+        // index of the current cell
+        size_t col = 0;
+
+        // whether a row was started but not yet terminated by a line break
+        bool pending()
+        {
+            return col > 0 || cells[0].size() > 0;
+        }
+    };
+
     struct CellStats
     {
-        double max = std::numeric_limits<double>::min();
+        ColumnType type = ColumnType::EMPTY;
+        double max = std::numeric_limits<double>::lowest();
         double min = std::numeric_limits<double>::max();
         double avg = 0;
+        // exact min and max of int columns
+        long long int_min = 0;
+        long long int_max = 0;
         double float_frac;
+        double null_frac;
         long no_distinct_vals;
         bool has_numeric_rows = false;
+        // share of true values for bool columns
+        double true_frac = 0;
+        // seconds since epoch (UTC) for date and timestamp columns
+        double min_time = 0;
+        double max_time = 0;
         vector<std::string> most_frequent;
     };
 
@@ -38,11 +64,14 @@ namespace csvsum
         bool sample;
         int no_samples;
 
-        void print_summary(vector<CellStats> &stats, vector<std::string> &col_names)
+    public:
+        static void print_summary(vector<CellStats> &stats, vector<std::string> &col_names)
         {
             fort::char_table table;
             table << fort::header
                   << "Column"
+                  << "Type"
+                  << "Nulls (%)"
                   << "Numeric Vals (%)"
                   << "Avg"
                   << "Min"
@@ -63,8 +92,22 @@ namespace csvsum
                     table << i;
                 }
 
-                table << std::setprecision(4) << c.float_frac * 100;
-                if (c.has_numeric_rows)
+                table << type_name(c.type);
+                table << std::setprecision(4) << c.null_frac * 100 << c.float_frac * 100;
+                if (c.type == ColumnType::DATE || c.type == ColumnType::TIMESTAMP)
+                {
+                    bool with_time = c.type == ColumnType::TIMESTAMP;
+                    table << "" << format_time(c.min_time, with_time) << format_time(c.max_time, with_time);
+                }
+                else if (c.type == ColumnType::BOOL)
+                {
+                    table << c.true_frac << (c.true_frac < 1 ? "false" : "true") << (c.true_frac > 0 ? "true" : "false");
+                }
+                else if (c.type == ColumnType::INT)
+                {
+                    table << c.avg << c.int_min << c.int_max;
+                }
+                else if (c.has_numeric_rows)
                 {
                     table << c.avg << c.min << c.max;
                 }
@@ -91,139 +134,134 @@ namespace csvsum
             std::cout << table.to_string() << std::endl;
         }
 
-        void inline read_char(const char &c, bool &escaped, bool &quoted, vector<std::string> &line, std::string &cell, vector<vector<std::string>> &lines)
+    protected:
+
+        // Parse a single character. Completed rows are directly added to the columns with weight w.
+        void inline read_char(const char &c, RowParser &p, ColumnSet &set, double w)
         {
-            if (c == quotechar && !escaped)
+            if (c == quotechar && !p.escaped)
             {
-                quoted = !quoted;
+                p.quoted = !p.quoted;
             }
-            else if ((c == line_break || c == sep) && !quoted && !escaped)
+            else if ((c == line_break || c == sep) && !p.quoted && !p.escaped)
             {
-                line.push_back(cell);
-                cell = "";
-
+                p.col++;
                 if (c == line_break)
                 {
-                    lines.push_back(line);
-                    vector<std::string> newline;
-                    line = newline;
+                    set.add_row(p.cells, p.col, w);
+                    p.col = 0;
                 }
+
+                if (p.col >= p.cells.size())
+                {
+                    p.cells.resize(p.col + 1);
+                }
+                p.cells[p.col].clear();
             }
-            else if (c == escape_char && !escaped)
+            else if (c == escape_char && !p.escaped)
             {
-                escaped = true;
+                p.escaped = true;
             }
             else
             {
-                cell += c;
-                escaped = false;
+                p.cells[p.col] += c;
+                p.escaped = false;
             }
         }
 
-        // Count how often cell values occur in each column
-        vector<std::unordered_map<std::string, double>> read_csv_cells(vector<vector<std::string>> &lines, vector<std::string> &col_names, vector<int> &row_sizes)
+        // Add a row which was not terminated by a line break (i.e., the last row of a file)
+        void finish_row(RowParser &p, ColumnSet &set, double w)
         {
-            vector<std::unordered_map<std::string, double>> cell_contens;
-            char c;
-
-            for (int i = 0; i < lines.size(); i++)
+            if (p.pending())
             {
-                for (int j = 0; j < lines[i].size(); j++)
-                {
-                    if (i == 0 && header)
-                    {
-                        col_names.push_back(lines[i][j]);
-                    }
-                    else
-                    {
-                        if (j >= cell_contens.size())
-                        {
-                            std::unordered_map<std::string, double> cm;
-                            cell_contens.push_back(cm);
-                        }
-
-                        // weight the occurence of each value. If we read the entire file, the weights are just 1. If we sample, we have to compensate that we are more likely to sample
-                        // larger rows (i.e., with more characters) so we weight by inverse row size.
-                        if (row_sizes.size() == 0)
-                        {
-                            if (cell_contens[j].count(lines[i][j]))
-                            {
-                                cell_contens[j][lines[i][j]] += 1;
-                            }
-                            else
-                            {
-                                cell_contens[j][lines[i][j]] = 1;
-                            }
-                        }
-                        else
-                        {
-                            int rs = header ? row_sizes[i - 1] : row_sizes[i];
-                            if (cell_contens[j].count(lines[i][j]))
-                            {
-                                cell_contens[j][lines[i][j]] += (double)1 / rs;
-                            }
-                            else
-                            {
-                                cell_contens[j][lines[i][j]] = (double)1 / rs;
-                            }
-                        }
-                    }
-                }
+                set.add_row(p.cells, p.col + 1, w);
+                p.col = 0;
+                p.cells[0].clear();
             }
-            return cell_contens;
         }
 
-        // Compute the statistics per column
-        void analyze_col(std::unordered_map<std::string, double> &cm, CellStats &c)
+        // Compute the statistics per column. The typed values were already aggregated while parsing, here we only
+        // have to find the most frequent values.
+        void analyze_col(ColumnAccumulator &col, CellStats &c)
         {
-            c.no_distinct_vals = cm.size();
-            std::priority_queue<std::pair<int, std::string>> q;
+            c.no_distinct_vals = col.counts.size();
 
-            double fwsum = 0;
-            double wsum = 0;
-
-            for (auto &value_count : cm)
+            if (col.top_k > 0)
             {
-                std::string val = value_count.first;
-                double w = value_count.second;
-                wsum += w;
-
-                // try to treat as numeric value and update stats
-                try
+                // the most frequent values were already tracked while parsing
+                for (size_t i = 0; i < col.top.size() && i < static_cast<size_t>(no_most_freq); i++)
                 {
-                    double fval = boost::lexical_cast<double>(val);
-
-                    c.has_numeric_rows = true;
-                    // compute weighted average
-                    c.avg += w * fval;
-                    fwsum += w;
-
-                    c.max = std::max(c.max, fval);
-                    c.min = std::min(c.min, fval);
+                    c.most_frequent.push_back(col.top[i].first);
                 }
-                catch (boost::bad_lexical_cast &)
+            }
+            else
+            {
+                std::priority_queue<std::pair<int, std::string>> q;
+                for (auto &value_count : col.counts)
                 {
+                    q.push(std::make_pair(-value_count.second.weight, value_count.first));
+                    if (q.size() > no_most_freq)
+                    {
+                        q.pop();
+                    }
                 }
 
-                q.push(std::make_pair(-w, val));
-                if (q.size() > no_most_freq)
+                while (!q.empty())
                 {
+                    c.most_frequent.push_back(q.top().second);
                     q.pop();
                 }
+                // more frequent elements first
+                std::reverse(c.most_frequent.begin(), c.most_frequent.end());
             }
-            c.avg /= fwsum;
-            c.float_frac = fwsum / wsum;
 
-            while (!q.empty())
+            c.type = col.type;
+            c.null_frac = col.null_weight / col.total_weight;
+            c.float_frac = col.num_weight / col.total_weight;
+            if (col.num_weight > 0)
             {
-                c.most_frequent.push_back(q.top().second);
-                // more frequent elements first
-                std::reverse(c.most_frequent.begin(), c.most_frequent.end());
-                q.pop();
+                c.has_numeric_rows = true;
+                c.avg = col.num_sum / col.num_weight;
+                c.min = col.num_min;
+                c.max = col.num_max;
+            }
+            if (col.type == ColumnType::INT)
+            {
+                c.int_min = col.int_min;
+                c.int_max = col.int_max;
+            }
+            if (col.bool_weight > 0)
+            {
+                c.true_frac = col.true_weight / col.bool_weight;
+            }
+            if (col.time_weight > 0)
+            {
+                c.min_time = col.time_min;
+                c.max_time = col.time_max;
+            }
+
+        }
+
+        vector<CellStats> analyze_cols(ColumnSet &set)
+        {
+            vector<CellStats> stats;
+            for (auto &column : set.columns)
+            {
+                CellStats c;
+                analyze_col(column, c);
+                stats.push_back(c);
             }
+            return stats;
         }
 
-        virtual vector<vector<std::string>> read_lines(vector<int> &row_sizes, long long &file_size, long long &no_rows, std::ifstream &in) = 0;
+        // Parse the file (either sample or full) into the given columns
+        virtual void read_rows(ColumnSet &set, long long &no_rows, std::ifstream &in) = 0;
+
+        // Describe the sample which the statistics are computed on
+        virtual std::string sample_description()
+        {
+            return "sample of size " + std::to_string(no_samples);
+        }
 
     public:
         CSVSummarizer(std::string path, bool header, char sep, char line_break, char escape_char, char quotechar, int no_most_freq, bool sample, int no_samples)
@@ -231,36 +269,33 @@ namespace csvsum
         {
         }
 
-        vector<CellStats> obtain_stats(bool verbose, vector<std::string> &col_names, long long &no_rows)
+        virtual ~CSVSummarizer()
+        {
+        }
+
+        virtual vector<CellStats> obtain_stats(bool verbose, vector<std::string> &col_names, long long &no_rows)
         {
             //std::cout << "Reading path: " << this->path << std::endl;
 
-            long long file_size;
             vector<CellStats> stats;
-            vector<int> row_sizes;
 
-            // read file (either sample or full)
+            // read file and aggregate the cells while parsing
             auto begin = std::chrono::steady_clock::now();
             std::ifstream in(path);
             if (in.fail()) {
                 std::cerr << "Could not read file " << this->path << std::endl;
                 return stats;
             }
-            vector<vector<std::string>> lines = read_lines(row_sizes, file_size, no_rows, in);
+            ColumnSet set(header);
+            read_rows(set, no_rows, in);
             in.close();
             auto end = std::chrono::steady_clock::now();
             if (verbose)
                 std::cout << "Time to read file = " << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << "[ms]" << std::endl;
 
             begin = std::chrono::steady_clock::now();
-            vector<std::unordered_map<std::string, double>> cell_contents = read_csv_cells(lines, col_names, row_sizes);
-
-            for (auto &cell_content : cell_contents)
-            {
-                CellStats c;
-                analyze_col(cell_content, c);
-                stats.push_back(c);
-            }
+            col_names = set.col_names;
+            stats = analyze_cols(set);
             end = std::chrono::steady_clock::now();
             if (verbose)
                 std::cout << "Time to compute statistics = " << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << "[ms]" << std::endl;
@@ -272,7 +307,7 @@ namespace csvsum
             return stats;
         }
 
-        void summarize(bool verbose)
+        virtual void summarize(bool verbose)
         {
             vector<std::string> col_names;
             long long no_rows;
@@ -282,7 +317,7 @@ namespace csvsum
             std::cout << (sample ? "Estimated total" : "Total") << " no rows: " << no_rows << std::endl;
             if (sample)
             {
-                std::cout << "Statistics on sample of size " << no_samples << ":" << std::endl;
+                std::cout << "Statistics on " << sample_description() << ":" << std::endl;
             }
 
             print_summary(stats, col_names);
@@ -0,0 +1,233 @@
+#pragma once
+
+#include <csvsum_base.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace csvsum
+{
+
+    class FollowCSVSummarizer : public CSVSummarizer
+    {
+    private:
+        // Parser state which is carried across reads, since an append can end in the middle of a record
+        RowParser parser;
+
+        // Accumulators which stay resident while the file grows. They track the most frequent values, so that a
+        // refresh does not have to visit every distinct value.
+        long long offset = 0;
+        ino_t inode = 0;
+        ColumnSet columns;
+
+        static const int buffer_size = 1 << 16;
+
+        void reset()
+        {
+            parser = RowParser();
+            offset = 0;
+            inode = 0;
+            columns = ColumnSet(header, no_most_freq);
+        }
+
+        // Only parse the bytes appended since the last read. Complete records are added to the columns, an incomplete
+        // trailing record remains in the parser state until the rest of it is appended.
+        void read_rows(ColumnSet &set, long long &no_rows, std::ifstream &in)
+        {
+            vector<char> buffer(buffer_size);
+
+            in.seekg(offset);
+            while (in.read(buffer.data(), buffer.size()) || in.gcount() > 0)
+            {
+                std::streamsize n = in.gcount();
+                for (std::streamsize i = 0; i < n; i++)
+                {
+                    read_char(buffer[i], parser, set, 1);
+                }
+                offset += n;
+            }
+
+            no_rows = set.no_rows;
+        }
+
+        void render(bool verbose)
+        {
+            vector<std::string> names;
+            long long no_rows;
+
+            auto begin = std::chrono::steady_clock::now();
+            vector<CellStats> stats = current_stats(names, no_rows);
+            auto end = std::chrono::steady_clock::now();
+
+            // redraw in place when writing to a terminal
+            if (isatty(STDOUT_FILENO))
+                std::cout << "\033[2J\033[H";
+            if (verbose)
+                std::cout << "Time to compute statistics = " << std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() << "[ms]" << std::endl;
+
+            std::cout << "Total no rows: " << no_rows << std::endl;
+            print_summary(stats, names);
+        }
+
+    public:
+        FollowCSVSummarizer(std::string path, bool header, char sep, char line_break, char escape_char, char quotechar, int no_most_freq)
+            : CSVSummarizer(path, header, sep, line_break, escape_char, quotechar, no_most_freq, false, 0), columns(header, no_most_freq)
+        {
+        }
+
+        FollowCSVSummarizer(std::string path, bool header, char sep) : CSVSummarizer(path, header, sep, '\n', '\\', '"', 3, false, 0), columns(header, 3)
+        {
+        }
+
+        // Parse the records appended since the last update and add them to the accumulators. If the file was
+        // replaced (e.g., by a log rotation) or shrank (e.g., it was truncated), the summary is started from scratch.
+        // Returns whether new records were added.
+        bool update()
+        {
+            struct stat st;
+            if (stat(path.c_str(), &st) != 0)
+            {
+                return false;
+            }
+            if (st.st_ino != inode || st.st_size < offset)
+            {
+                reset();
+                inode = st.st_ino;
+            }
+            if (st.st_size == offset)
+            {
+                return false;
+            }
+
+            std::ifstream in(path);
+            if (in.fail())
+            {
+                return false;
+            }
+
+            long long prev_rows = columns.no_rows;
+            long long no_rows;
+            read_rows(columns, no_rows, in);
+
+            return no_rows > prev_rows;
+        }
+
+        // The summary always reflects the records parsed so far, hence both entry points of the base class only
+        // parse what was appended since the last update.
+        vector<CellStats> obtain_stats(bool /* verbose */, vector<std::string> &col_names, long long &no_rows)
+        {
+            update();
+            return current_stats(col_names, no_rows);
+        }
+
+        void summarize(bool verbose)
+        {
+            update();
+            render(verbose);
+        }
+
+        vector<CellStats> current_stats(vector<std::string> &col_names, long long &no_rows)
+        {
+            col_names = columns.col_names;
+            no_rows = columns.no_rows;
+            return analyze_cols(columns);
+        }
+
+        // Summarize the file and keep watching it for appends. New records are parsed as soon as they are
+        // written, the summary is re-rendered at most every interval_ms milliseconds (which has to be positive). If the file is moved or
+        // deleted (e.g., by a log rotation), the summary starts from scratch once the file is recreated.
+        void follow(bool verbose, int interval_ms)
+        {
+            const uint32_t mask = IN_MODIFY | IN_MOVE_SELF | IN_DELETE_SELF | IN_ATTRIB;
+            int fd = inotify_init1(IN_NONBLOCK);
+            if (fd < 0)
+            {
+                std::cerr << "Could not initialize inotify." << std::endl;
+                return;
+            }
+            int wd = inotify_add_watch(fd, path.c_str(), mask);
+            if (wd < 0)
+            {
+                std::cerr << "Could not read file " << this->path << std::endl;
+                close(fd);
+                return;
+            }
+
+            update();
+            render(verbose);
+
+            bool changed = false;
+            auto last_render = std::chrono::steady_clock::now();
+            alignas(struct inotify_event) char events[4096];
+
+            while (true)
+            {
+                int timeout = -1;
+                if (changed)
+                {
+                    long long elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - last_render).count();
+                    timeout = std::max(0LL, interval_ms - elapsed);
+                }
+                else if (wd < 0)
+                {
+                    // wait for the file to be recreated
+                    timeout = interval_ms;
+                }
+
+                struct pollfd pfd = {fd, POLLIN, 0};
+                int ret = poll(&pfd, 1, timeout);
+                if (ret < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    break;
+                }
+                if (ret > 0)
+                {
+                    bool replaced = false;
+                    ssize_t len;
+                    while ((len = read(fd, events, sizeof(events))) > 0)
+                    {
+                        for (char *e = events; e < events + len; e += sizeof(struct inotify_event) + reinterpret_cast<struct inotify_event *>(e)->len)
+                        {
+                            struct inotify_event *event = reinterpret_cast<struct inotify_event *>(e);
+                            if (event->mask & (IN_MOVE_SELF | IN_DELETE_SELF | IN_ATTRIB | IN_IGNORED))
+                                replaced = true;
+                        }
+                    }
+
+                    // the watch is bound to the inode, so it has to be renewed if the path now points to another file
+                    if (replaced)
+                    {
+                        struct stat st;
+                        if (stat(path.c_str(), &st) != 0 || st.st_ino != inode)
+                        {
+                            if (wd >= 0)
+                                inotify_rm_watch(fd, wd);
+                            wd = -1;
+                            reset();
+                            changed = true;
+                        }
+                    }
+                }
+                if (wd < 0)
+                {
+                    wd = inotify_add_watch(fd, path.c_str(), mask);
+                }
+                changed = update() || changed;
+
+                auto now = std::chrono::steady_clock::now();
+                if (changed && std::chrono::duration_cast<std::chrono::milliseconds>(now - last_render).count() >= interval_ms)
+                {
+                    render(verbose);
+                    changed = false;
+                    last_render = now;
+                }
+            }
+
+            close(fd);
+        }
+    };
+}
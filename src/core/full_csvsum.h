@@ -8,49 +8,101 @@ namespace csvsum
     class FullCSVSummarizer : public CSVSummarizer
     {
     private:
-        // Just read the file line per line into a vector of vectors (representing cells)
-        // Also consider quoted and escaped newlines.
-        vector<vector<std::string>> read_lines(vector<int> &row_sizes, long long &file_size, long long &no_rows, std::ifstream &in)
-        {
-            bool escaped = false;
-            bool quoted = false;
+        // Number of bytes to read, the file is read entirely if negative. Incomplete records at the end are dropped.
+        long long max_bytes;
+
+        // State of an incremental scan (see scan()). The columns track their most frequent values, so that the
+        // statistics can be computed without visiting every distinct value.
+        RowParser scan_parser;
+        ColumnSet scanned;
+        long long scanned_bytes = 0;
+        bool scan_complete = false;
+
+        static constexpr int buffer_size = 1 << 16;
 
-            int colIdx = 0;
-            std::string cell;
-            vector<vector<std::string>> lines;
-            char c;
-            vector<std::string> line;
+        // Parse at most max_bytes bytes (the rest of the file if negative) in blocks and add each row to the columns
+        // as soon as it is complete. Also consider quoted and escaped newlines. Returns the number of bytes read,
+        // at_end is set if the end of the file was reached.
+        long long read_blocks(RowParser &p, ColumnSet &set, std::ifstream &in, long long max_bytes, bool &at_end)
+        {
+            vector<char> buffer(buffer_size);
+            long long remaining = max_bytes;
+            long long read = 0;
+            at_end = false;
 
-            if (in.is_open())
+            while (max_bytes < 0 || remaining > 0)
             {
-                while (in.good())
+                std::streamsize n = max_bytes < 0 ? buffer_size : std::min<long long>(buffer_size, remaining);
+                in.read(buffer.data(), n);
+                n = in.gcount();
+                if (n == 0)
+                {
+                    // the last row might not be terminated by a line break
+                    finish_row(p, set, 1);
+                    at_end = true;
+                    break;
+                }
+                for (std::streamsize i = 0; i < n; i++)
                 {
-                    in.get(c);
-                    read_char(c, escaped, quoted, line, cell, lines);
+                    read_char(buffer[i], p, set, 1);
                 }
+                remaining -= n;
+                read += n;
             }
 
-            // remove last line if applicable
-            if (lines[lines.size() - 1].size() == 1 && lines[lines.size() - 1][0] == "")
+            return read;
+        }
+
+        void read_rows(ColumnSet &set, long long &no_rows, std::ifstream &in)
+        {
+            RowParser p;
+            bool at_end;
+            read_blocks(p, set, in, max_bytes, at_end);
+            no_rows = set.no_rows;
+        }
+
+    public:
+        FullCSVSummarizer(std::string path, bool header, char sep, char line_break, char escape_char, char quotechar, int no_most_freq, long long max_bytes = -1)
+            : CSVSummarizer(path, header, sep, line_break, escape_char, quotechar, no_most_freq, false, 0), max_bytes(max_bytes), scanned(header, no_most_freq)
+        {
+        }
+
+        FullCSVSummarizer(std::string path, bool header, char sep) : CSVSummarizer(path, header, sep, '\n', '\\', '"', 3, false, 0), max_bytes(-1), scanned(header, 3)
+        {
+        }
+
+        // Continue the incremental scan until the first max_bytes bytes of the file were read (the whole file if
+        // negative). The rows read so far are kept, so a scan of a prefix can be extended to the whole file without
+        // parsing the prefix again. Returns whether the whole file was read.
+        bool scan(long long max_bytes)
+        {
+            if (scan_complete)
             {
-                lines.pop_back();
+                return true;
             }
 
-            no_rows = lines.size();
-            if (header)
-                no_rows--;
-            
-            return lines;
+            std::ifstream in(path);
+            if (in.fail())
+            {
+                std::cerr << "Could not read file " << this->path << std::endl;
+                return false;
+            }
+            in.seekg(scanned_bytes);
+            scanned_bytes += read_blocks(scan_parser, scanned, in, max_bytes < 0 ? -1 : std::max(0LL, max_bytes - scanned_bytes), scan_complete);
+            return scan_complete;
         }
 
-    public:
-        FullCSVSummarizer(std::string path, bool header, char sep, char line_break, char escape_char, char quotechar, int no_most_freq)
-            : CSVSummarizer(path, header, sep, line_break, escape_char, quotechar, no_most_freq, false, 0)
+        // Number of bytes read by the incremental scan
+        long long scanned_size()
         {
+            return scanned_bytes;
         }
 
-        FullCSVSummarizer(std::string path, bool header, char sep) : CSVSummarizer(path, header, sep, '\n', '\\', '"', 3, false, 0)
+        vector<CellStats> scanned_stats(vector<std::string> &col_names, long long &no_rows)
         {
+            col_names = scanned.col_names;
+            no_rows = scanned.no_rows;
+            return analyze_cols(scanned);
         }
     };
 }
@@ -1,18 +1,52 @@
 #pragma once
 
 #include <csvsum_base.h>
-#include <stdlib.h>
+#include "xoshiro.h"
+#include <atomic>
+#include <cmath>
+#include <thread>
 
 namespace csvsum
 {
     class SampleCSVSummarizer : public CSVSummarizer
     {
+    public:
+        // Samples are drawn in chunks of this size, each chunk with its own random stream. Hence, the sampled rows
+        // only depend on the seed and not on the number of threads.
+        static constexpr int chunk_size = 64;
+
     private:
         int skip_value;
+        uint64_t seed;
+        int no_threads;
 
-        std::string read_surrounding_line(long long &offset, std::ifstream &in)
+        struct SampleChunk
+        {
+            ColumnSet set;
+            // sum of the row weights (inverse row widths) and of their squares
+            double inv_rwidth_sum = 0;
+            double inv_rwidth_sq_sum = 0;
+        };
+
+        // complete chunks of the last sample, merged in chunk order. They are only reused if the sample is grown
+        // explicitly (see grow_sample()) and the file was not changed in between.
+        SampleChunk drawn;
+        int no_drawn_chunks = 0;
+        long long drawn_minlength = -1;
+        long long drawn_maxlength = -1;
+        bool grow = false;
+
+        double ess = 0;
+
+        std::string sample_description()
         {
+            return CSVSummarizer::sample_description() + " (seed " + std::to_string(seed) + ")";
+        }
 
+        std::string read_surrounding_line(long long &offset, std::ifstream &in)
+        {
+            // a previous read might have hit the end of the file
+            in.clear();
             in.seekg(offset);
 
             char c;
@@ -20,9 +54,8 @@ namespace csvsum
             std::string line = "";
 
             // forward search
-            while (in.good())
+            while (in.get(c))
             {
-                in.get(c);
                 line += c;
                 if ((c == line_break) && !escaped)
                 {
@@ -39,6 +72,7 @@ namespace csvsum
             }
 
             // backward search
+            in.clear();
             std::string prefix = "";
             escaped = false;
             bool done = false;
@@ -81,75 +115,181 @@ namespace csvsum
             return line;
         }
 
-        // Just read the file line per line into a vector of vectors (representing cells)
-        // Also consider quoted and escaped newlines.
-        vector<vector<std::string>> read_lines(vector<int> &row_sizes, long long &file_size, long long &no_rows, std::ifstream &in)
+        void sample_chunk(Xoshiro256 rng, int count, long long minlength, long long maxlength, std::ifstream &in, SampleChunk &chunk)
         {
-            bool escaped = false;
-            bool quoted = false;
-            std::string cell;
-            vector<vector<std::string>> lines;
-            char c;
-            vector<std::string> line;
+            RowParser p;
 
-            // skip header if applicable
-            if (header)
+            for (int i = 0; i < count; i++)
             {
-                while (in.good() && lines.size() == 0)
+                long long offset = (maxlength - minlength) * rng.next_double() + minlength;
+                std::string currline = read_surrounding_line(offset, in);
+
+                // weight the occurence of each value. We have to compensate that we are more likely to sample
+                // larger rows (i.e., with more characters) so we weight by inverse row size. The size is taken
+                // before terminating the row, since only the characters in the file make a row more likely.
+                double w = (double)1 / std::max<size_t>(currline.size(), 1);
+                chunk.inv_rwidth_sum += w;
+                chunk.inv_rwidth_sq_sum += w * w;
+
+                // the last row might not be terminated
+                if (currline.size() == 0 || currline[currline.size() - 1] != line_break)
                 {
-                    in.get(c);
-                    read_char(c, escaped, quoted, line, cell, lines);
+                    currline += line_break;
                 }
+                for (char c : currline)
+                {
+                    read_char(c, p, chunk.set, w);
+                }
+            }
+        }
+
+        static void merge_chunk(SampleChunk &into, const SampleChunk &chunk)
+        {
+            into.set.merge(chunk.set);
+            into.inv_rwidth_sum += chunk.inv_rwidth_sum;
+            into.inv_rwidth_sq_sum += chunk.inv_rwidth_sq_sum;
+        }
+
+        // Sample rows at random offsets and add them to the columns.
+        // Also consider escaped newlines.
+        void read_rows(ColumnSet &set, long long &no_rows, std::ifstream &in)
+        {
+            RowParser p;
+            char c;
+
+            // read header if applicable
+            while (set.has_header && in.get(c))
+            {
+                read_char(c, p, set, 1);
             }
 
             // find out where file can be read
             long long minlength = in.tellg();
             in.seekg(0, in.end);
             long long maxlength = in.tellg();
-            file_size = maxlength - minlength;
+            long long file_size = maxlength - minlength;
 
-            // sample rows and parse them
-            std::string currline = "";
-            // The goal is to estimate the avg number of chars per row. Since we observe a biased sample (larger rows are seen more often),
-            // we have to keep track of inverted sum of row widths
-            double inv_rwidth_sum = 0;
+            // derive an independent random stream for every chunk which was not drawn yet
+            int no_chunks = (this->no_samples + chunk_size - 1) / chunk_size;
+            if (!grow || no_drawn_chunks > no_chunks || minlength != drawn_minlength || maxlength != drawn_maxlength)
+            {
+                drawn = SampleChunk();
+                no_drawn_chunks = 0;
+                drawn_minlength = minlength;
+                drawn_maxlength = maxlength;
+            }
+            grow = false;
+            int first_chunk = no_drawn_chunks;
+            vector<Xoshiro256> streams;
+            Xoshiro256 rng(seed);
+            for (int i = 0; i < no_chunks; i++)
+            {
+                if (i >= first_chunk)
+                    streams.push_back(rng);
+                rng.jump();
+            }
+
+            // sample rows and parse them. Every worker uses its own file handle and parser state.
+            int no_new_chunks = no_chunks - first_chunk;
+            vector<SampleChunk> chunks(no_new_chunks);
+            std::atomic<int> next_chunk(0);
+            std::atomic<bool> failed(false);
+            auto worker = [&]()
+            {
+                std::ifstream win(path);
+                if (win.fail())
+                {
+                    failed = true;
+                    return;
+                }
+                for (int i = next_chunk++; i < no_new_chunks && !failed; i = next_chunk++)
+                {
+                    int count = std::min(chunk_size, this->no_samples - (first_chunk + i) * chunk_size);
+                    sample_chunk(streams[i], count, minlength, maxlength, win, chunks[i]);
+                }
+            };
 
-            for (int i = 0; i < this->no_samples; i++)
+            vector<std::thread> workers;
+            for (int i = 1; i < std::min(no_threads, no_new_chunks); i++)
+            {
+                workers.emplace_back(worker);
+            }
+            worker();
+            for (auto &w : workers)
             {
-                long long offset = (maxlength - minlength) * (rand() / (double)RAND_MAX) + minlength;
-                currline = read_surrounding_line(offset, in);
-                row_sizes.push_back(currline.size());
+                w.join();
+            }
 
-                inv_rwidth_sum += (double)1 / currline.size();
+            // an incomplete sample would be biased, hence the whole sample fails
+            if (failed)
+            {
+                std::cerr << "Could not read file " << this->path << std::endl;
+                set = ColumnSet(header);
+                no_rows = 0;
+                ess = 0;
+                return;
+            }
 
-                for (char c : currline)
+            // merge in chunk order, so that the result does not depend on the number of threads. Complete chunks are
+            // kept, only an incomplete last chunk has to be drawn again if the sample grows.
+            SampleChunk partial;
+            for (int i = 0; i < no_new_chunks; i++)
+            {
+                if ((first_chunk + i + 1) * chunk_size <= this->no_samples)
+                {
+                    merge_chunk(drawn, chunks[i]);
+                    no_drawn_chunks++;
+                }
+                else
                 {
-                    read_char(c, escaped, quoted, line, cell, lines);
+                    partial = std::move(chunks[i]);
                 }
             }
+            set.merge(drawn.set);
+            set.merge(partial.set);
+
+            // The goal is to estimate the avg number of chars per row. Since we observe a biased sample (larger rows are seen more often),
+            // we have to keep track of inverted sum of row widths
+            double inv_rwidth_sum = drawn.inv_rwidth_sum + partial.inv_rwidth_sum;
+
+            // effective sample size of the weighted sample (Kish)
+            ess = inv_rwidth_sum * inv_rwidth_sum / (drawn.inv_rwidth_sq_sum + partial.inv_rwidth_sq_sum);
 
             double avg_row_width = this->no_samples / inv_rwidth_sum;
             no_rows = std::round(file_size / avg_row_width);
-
-            return lines;
         }
 
     public:
         // this summarizer does not support quotechars (since in this case it is not clear when to stop reading).
         // Hence, this character defaults to \0
-        SampleCSVSummarizer(std::string path, bool header, char sep, char line_break, char escape_char, int no_most_freq, int no_samples, int skip_value)
-            : skip_value(skip_value), CSVSummarizer(path, header, sep, line_break, escape_char, '\0', no_most_freq, true, no_samples)
+        SampleCSVSummarizer(std::string path, bool header, char sep, char line_break, char escape_char, int no_most_freq, int no_samples, int skip_value, uint64_t seed = 0, int no_threads = 1)
+            : CSVSummarizer(path, header, sep, line_break, escape_char, '\0', no_most_freq, true, no_samples), skip_value(skip_value), seed(seed), no_threads(no_threads)
         {
         }
 
         SampleCSVSummarizer(std::string path, bool header, char sep, int no_samples, int skip_value)
-            : skip_value(skip_value), CSVSummarizer(path, header, sep, '\n', '\\', '\0', 3, true, no_samples)
+            : CSVSummarizer(path, header, sep, '\n', '\\', '\0', 3, true, no_samples), skip_value(skip_value), seed(0), no_threads(1)
         {
         }
 
         SampleCSVSummarizer(std::string path, bool header, char sep) : SampleCSVSummarizer(path, header, sep, 1000, 100)
         {
         }
+
+        // Let the next sample extend the last one to no_samples rows. Only the additional rows are drawn and the
+        // result is the same as drawing the larger sample directly. The sample is drawn from scratch if the file
+        // changed in between.
+        void grow_sample(int no_samples)
+        {
+            this->no_samples = no_samples;
+            grow = true;
+        }
+
+        // Effective sample size of the last sample, i.e., (sum w)^2 / sum w^2 for the inverse row size weights
+        double effective_sample_size()
+        {
+            return ess;
+        }
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+
+namespace csvsum
+{
+    // xoshiro256** pseudo random number generator (see https://prng.di.unimi.it/). jump() advances the state by 2^128
+    // calls of next(), so that non-overlapping streams can be derived from a single seed.
+    class Xoshiro256
+    {
+    private:
+        uint64_t s[4];
+
+        static uint64_t rotl(uint64_t x, int k)
+        {
+            return (x << k) | (x >> (64 - k));
+        }
+
+    public:
+        // the state is initialized from the seed with splitmix64
+        explicit Xoshiro256(uint64_t seed)
+        {
+            for (int i = 0; i < 4; i++)
+            {
+                seed += 0x9e3779b97f4a7c15;
+                uint64_t z = seed;
+                z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+                z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+                s[i] = z ^ (z >> 31);
+            }
+        }
+
+        uint64_t next()
+        {
+            uint64_t result = rotl(s[1] * 5, 7) * 9;
+            uint64_t t = s[1] << 17;
+
+            s[2] ^= s[0];
+            s[3] ^= s[1];
+            s[1] ^= s[2];
+            s[0] ^= s[3];
+            s[2] ^= t;
+            s[3] = rotl(s[3], 45);
+
+            return result;
+        }
+
+        // uniformly distributed in [0, 1)
+        double next_double()
+        {
+            return (next() >> 11) * (1.0 / (uint64_t(1) << 53));
+        }
+
+        void jump()
+        {
+            static const uint64_t JUMP[] = {0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4528b1a2bd};
+
+            uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+            for (uint64_t j : JUMP)
+            {
+                for (int b = 0; b < 64; b++)
+                {
+                    if (j & (uint64_t(1) << b))
+                    {
+                        s0 ^= s[0];
+                        s1 ^= s[1];
+                        s2 ^= s[2];
+                        s3 ^= s[3];
+                    }
+                    next();
+                }
+            }
+            s[0] = s0;
+            s[1] = s1;
+            s[2] = s2;
+            s[3] = s3;
+        }
+    };
+}
@@ -1,6 +1,8 @@
 #include "../core/csvsum.h"
 #include <argparse/argparse.hpp>
 #include <iostream>
+#include <random>
+#include <thread>
 
 char to_char(std::string str, std::string arg)
 {
@@ -47,10 +49,35 @@ int main(int argc, char *argv[])
         .scan<'d', int>()
         .help("number of rows to sample.");
 
+    program.add_argument("--seed")
+        .scan<'u', unsigned long long>()
+        .help("seed for drawing the sample. A random seed is used if not specified.");
+
+    program.add_argument("--threads")
+        .default_value(static_cast<int>(std::max(1u, std::thread::hardware_concurrency())))
+        .required()
+        .scan<'d', int>()
+        .help("number of threads used for drawing the sample.");
+
+    program.add_argument("-t", "--time_budget")
+        .scan<'d', int>()
+        .help("number of milliseconds the summary may take. Picks between a full scan and sampling automatically.");
+
     program.add_argument("--no_header")
         .default_value(false)
         .implicit_value(true);
 
+    program.add_argument("-f", "--follow")
+        .default_value(false)
+        .implicit_value(true)
+        .help("keep watching the file and update the summary when rows are appended.");
+
+    program.add_argument("--interval")
+        .default_value(1000)
+        .required()
+        .scan<'d', int>()
+        .help("minimum number of milliseconds between two summary updates in the follow mode.");
+
     program.add_argument("--verbose")
         .default_value(false)
         .implicit_value(true);
@@ -84,12 +111,55 @@ int main(int argc, char *argv[])
     char escape_char = to_char(program.get<std::string>("--escape_char"), "escape_char");
     char quotechar = to_char(program.get<std::string>("--quote_char"), "quote_char");
     int no_samples = program.get<int>("--sample");
+    auto time_budget_arg = program.present<int>("--time_budget");
+    int time_budget = time_budget_arg ? *time_budget_arg : 0;
+    int no_threads = std::max(1, program.get<int>("--threads"));
+    uint64_t seed = std::random_device()();
+    if (auto seed_arg = program.present<unsigned long long>("--seed"))
+    {
+        seed = *seed_arg;
+    }
     bool header = !program.get<bool>("--no_header");
     bool verbose = program.get<bool>("--verbose");
     int no_most_freq = program.get<int>("--no_most_freq");
     int block_read = program.get<int>("--block_read");
+    bool follow = program.get<bool>("--follow");
+    int interval = program.get<int>("--interval");
+
+    if (time_budget_arg && time_budget <= 0)
+    {
+        std::cerr << "The time budget has to be positive." << std::endl;
+        std::exit(1);
+    }
 
-    if (no_samples == 0)
+    if (interval <= 0)
+    {
+        std::cerr << "The interval has to be positive." << std::endl;
+        std::exit(1);
+    }
+
+    if (no_samples != 0 && time_budget_arg)
+    {
+        std::cerr << "Specify either a sample size or a time budget." << std::endl;
+        std::exit(1);
+    }
+
+    if (follow)
+    {
+        if (no_samples != 0 || time_budget_arg)
+        {
+            std::cerr << "Sampling is not supported for follow mode." << std::endl;
+            std::exit(1);
+        }
+        std::unique_ptr<csvsum::FollowCSVSummarizer> s(new csvsum::FollowCSVSummarizer(path, header, sep, line_break, escape_char, quotechar, no_most_freq));
+        s->follow(verbose, interval);
+    }
+    else if (time_budget_arg)
+    {
+        std::unique_ptr<csvsum::AdaptiveCSVSummarizer> s(new csvsum::AdaptiveCSVSummarizer(path, header, sep, line_break, escape_char, quotechar, no_most_freq, block_read, time_budget, seed, no_threads));
+        s->summarize(verbose);
+    }
+    else if (no_samples == 0)
     {
         std::unique_ptr<csvsum::FullCSVSummarizer> s(new csvsum::FullCSVSummarizer(path, header, sep, line_break, escape_char, quotechar, no_most_freq));
         s->summarize(verbose);
@@ -101,7 +171,7 @@ int main(int argc, char *argv[])
             std::cerr << "Quotechars are not supported for sampling mode." << std::endl;
             std::exit(1);
         }
-        std::unique_ptr<csvsum::SampleCSVSummarizer> s(new csvsum::SampleCSVSummarizer(path, header, sep, line_break, escape_char, no_most_freq, no_samples, block_read));
+        std::unique_ptr<csvsum::SampleCSVSummarizer> s(new csvsum::SampleCSVSummarizer(path, header, sep, line_break, escape_char, no_most_freq, no_samples, block_read, seed, no_threads));
         s->summarize(verbose);
     }
 
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "csvsum.h"
+#include "unittest_csvsum.h"
+#include <filesystem>
+#include <iostream>
+
+using namespace csvsum;
+
+TEST_SUITE("csvsum_adaptive")
+{
+    TEST_CASE("full_within_budget")
+    {
+        vector<std::string> col_names;
+        long long no_rows;
+        std::unique_ptr<csvsum::AdaptiveCSVSummarizer> adaptive_sum(new csvsum::AdaptiveCSVSummarizer(resource_dir + "simple_no_quote.csv", true, ',', 10000));
+
+        // the file is smaller than the first probe, so the probe is the summary
+        SummaryPlan plan = adaptive_sum->plan(false);
+        CHECK(plan.complete);
+        CHECK(!plan.sample);
+
+        vector<CellStats> stats = adaptive_sum->obtain_stats(false, plan, col_names, no_rows);
+
+        check_simple_no_quote(col_names, no_rows, stats);
+    }
+
+    TEST_CASE("sample_exceeding_budget")
+    {
+        std::string path = (std::filesystem::temp_directory_path() / "csvsum_adaptive.csv").string();
+        std::ofstream out(path, std::ios::trunc);
+        out << "letter,value\n";
+        for (int i = 0; i < 100000; i++)
+        {
+            out << (i % 3 == 0 ? "BBBBBBBBB" : "A") << "," << i % 10 << "\n";
+        }
+        out.close();
+
+        // a full scan can never fit into an empty budget
+        std::unique_ptr<csvsum::AdaptiveCSVSummarizer> adaptive_sum(new csvsum::AdaptiveCSVSummarizer(path, true, ',', 0));
+        SummaryPlan plan = adaptive_sum->plan(false);
+        CHECK(plan.sample);
+        CHECK(plan.no_samples >= 100);
+
+        // the pilot sample is grown into the final sample, which is the same as drawing it directly
+        vector<std::string> col_names, direct_col_names;
+        long long no_rows, direct_no_rows;
+        vector<CellStats> stats = adaptive_sum->obtain_stats(false, plan, col_names, no_rows);
+        std::unique_ptr<csvsum::SampleCSVSummarizer> sample_sum(new csvsum::SampleCSVSummarizer(path, true, ',', '\n', '\\', 3, plan.no_samples, 100, 0, 1));
+        vector<CellStats> direct_stats = sample_sum->obtain_stats(false, direct_col_names, direct_no_rows);
+
+        CHECK(no_rows == direct_no_rows);
+        CHECK(stats.size() == direct_stats.size());
+        for (size_t i = 0; i < std::min(stats.size(), direct_stats.size()); i++)
+        {
+            CHECK(stats[i].avg == direct_stats[i].avg);
+            CHECK(stats[i].most_frequent == direct_stats[i].most_frequent);
+        }
+
+        std::filesystem::remove(path);
+    }
+}
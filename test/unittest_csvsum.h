@@ -18,6 +18,7 @@ void check_simple_no_quote(vector<std::string> &col_names, long long &no_rows, v
     CHECK(col_names[1] == "value");
 
     // Check that stats are correct
+    CHECK(stats[0].type == ColumnType::STRING);
     CHECK(!stats[0].has_numeric_rows);
     CHECK(stats[0].no_distinct_vals == 2);
     CHECK(stats[0].most_frequent.size() == 2);
@@ -30,6 +31,7 @@ void check_simple_no_quote(vector<std::string> &col_names, long long &no_rows, v
     CHECK(stats[1].float_frac == doctest::Approx((double)2 / 3).epsilon(0.01));
     CHECK(stats[1].no_distinct_vals == 3);
     CHECK(stats[1].has_numeric_rows);
+    CHECK(stats[1].type == ColumnType::STRING);
 }
 
 void check_quoted_escaped(vector<std::string> &col_names, long long &no_rows, vector<CellStats> &stats)
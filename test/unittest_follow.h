@@ -0,0 +1,108 @@
+#pragma once
+
+#include "csvsum.h"
+#include "unittest_csvsum.h"
+#include <filesystem>
+#include <iostream>
+
+using namespace csvsum;
+
+TEST_SUITE("csvsum_follow")
+{
+    TEST_CASE("appended_records")
+    {
+        std::string path = (std::filesystem::temp_directory_path() / "csvsum_follow.csv").string();
+        std::ofstream out(path, std::ios::trunc);
+        vector<std::string> col_names;
+        long long no_rows;
+        std::unique_ptr<csvsum::FollowCSVSummarizer> follow_sum(new csvsum::FollowCSVSummarizer(path, true, ','));
+
+        // the last record is incomplete and must not be counted yet
+        out << "letter,value\nA,0.8\nBBBB" << std::flush;
+        CHECK(follow_sum->update());
+        vector<CellStats> stats = follow_sum->current_stats(col_names, no_rows);
+        CHECK(no_rows == 1);
+        CHECK(stats.size() == 2);
+        CHECK(stats[0].most_frequent[0] == "A");
+
+        CHECK(!follow_sum->update());
+
+        out << "BBBBB,0.2\nA,C\n" << std::flush;
+        CHECK(follow_sum->update());
+        stats = follow_sum->current_stats(col_names, no_rows);
+        check_simple_no_quote(col_names, no_rows, stats);
+
+        out.close();
+        std::filesystem::remove(path);
+    }
+
+    TEST_CASE("tracked_most_frequent")
+    {
+        std::string path = (std::filesystem::temp_directory_path() / "csvsum_follow_frequent.csv").string();
+        std::ofstream out(path, std::ios::trunc);
+        vector<std::string> col_names;
+        long long no_rows;
+        std::unique_ptr<csvsum::FollowCSVSummarizer> follow_sum(new csvsum::FollowCSVSummarizer(path, true, ','));
+
+        // values which are appended later overtake the ones which were most frequent so far
+        out << "id\n";
+        for (int round = 0; round < 5; round++)
+        {
+            for (int i = 0; i < 20; i++)
+            {
+                out << "v" << i % (5 + 3 * round) << "\n";
+                out << "w" << round << "\n";
+            }
+            for (int i = 0; i < 4 * round; i++)
+            {
+                out << "w" << round << "\n";
+            }
+            out << std::flush;
+            CHECK(follow_sum->update());
+        }
+        vector<CellStats> stats = follow_sum->current_stats(col_names, no_rows);
+
+        vector<std::string> full_col_names;
+        long long full_no_rows;
+        std::unique_ptr<csvsum::FullCSVSummarizer> full_sum(new csvsum::FullCSVSummarizer(path, true, ','));
+        vector<CellStats> full_stats = full_sum->obtain_stats(false, full_col_names, full_no_rows);
+
+        CHECK(no_rows == full_no_rows);
+        CHECK(stats[0].most_frequent.size() == 3);
+        CHECK(stats[0].most_frequent == full_stats[0].most_frequent);
+        CHECK(stats[0].most_frequent[0] == "w4");
+
+        out.close();
+        std::filesystem::remove(path);
+    }
+
+    TEST_CASE("rotated_file")
+    {
+        std::string path = (std::filesystem::temp_directory_path() / "csvsum_follow_rotated.csv").string();
+        std::ofstream out(path, std::ios::trunc);
+        vector<std::string> col_names;
+        long long no_rows;
+        std::unique_ptr<csvsum::FollowCSVSummarizer> follow_sum(new csvsum::FollowCSVSummarizer(path, true, ','));
+
+        out << "letter,value\nX,1\n";
+        out.close();
+        CHECK(follow_sum->update());
+
+        // rotate the file and recreate it with more bytes than were already read
+        std::filesystem::rename(path, path + ".1");
+        out.open(path, std::ios::trunc);
+        out << "letter,value\nA,0.8\nA,0.2\n";
+        out.close();
+        CHECK(follow_sum->update());
+
+        // the base class entry points must not read the file again
+        vector<CellStats> stats = follow_sum->obtain_stats(false, col_names, no_rows);
+        stats = follow_sum->obtain_stats(false, col_names, no_rows);
+        CHECK(no_rows == 2);
+        CHECK(col_names.size() == 2);
+        CHECK(stats[0].most_frequent[0] == "A");
+
+        std::filesystem::remove(path);
+        std::filesystem::remove(path + ".1");
+    }
+}
\ No newline at end of file
@@ -30,4 +30,76 @@ TEST_SUITE("csvsum_full_pass")
 
         check_quoted_escaped(col_names, no_rows, stats);
     }
+
+    TEST_CASE("incremental_scan")
+    {
+        vector<std::string> col_names;
+        long long no_rows;
+        std::unique_ptr<csvsum::FullCSVSummarizer> full_sum(new csvsum::FullCSVSummarizer(resource_dir + "quoted_escaped.csv", true, ',', '\n', '\\', '"', 3));
+
+        // continue the scan in steps which end in the middle of records
+        CHECK(!full_sum->scan(7));
+        CHECK(!full_sum->scan(23));
+        CHECK(full_sum->scan(-1));
+        vector<CellStats> stats = full_sum->scanned_stats(col_names, no_rows);
+
+        check_quoted_escaped(col_names, no_rows, stats);
+    }
+
+    TEST_CASE("typed_columns")
+    {
+        vector<std::string> col_names;
+        long long no_rows;
+        std::unique_ptr<csvsum::FullCSVSummarizer> full_sum(new csvsum::FullCSVSummarizer(resource_dir + "typed_columns.csv", true, ','));
+
+        vector<CellStats> stats = full_sum->obtain_stats(false, col_names, no_rows);
+
+        CHECK(no_rows == 3);
+        CHECK(stats.size() == 10);
+
+        CHECK(stats[0].type == ColumnType::INT);
+        CHECK(stats[0].min == -3);
+        CHECK(stats[0].max == 2);
+        CHECK(stats[0].avg == 0);
+
+        // int values do not demote a double column
+        CHECK(stats[1].type == ColumnType::DOUBLE);
+        CHECK(stats[1].min == 2.5);
+        CHECK(stats[1].max == 4.5);
+        CHECK(stats[1].avg == doctest::Approx((double)10 / 3).epsilon(0.01));
+
+        CHECK(stats[2].type == ColumnType::BOOL);
+        CHECK(!stats[2].has_numeric_rows);
+        CHECK(stats[2].true_frac == doctest::Approx((double)2 / 3).epsilon(0.01));
+
+        CHECK(stats[3].type == ColumnType::DATE);
+        CHECK(format_time(stats[3].min_time, false) == "2021-01-15");
+        CHECK(format_time(stats[3].max_time, false) == "2021-12-31");
+
+        // dates are promoted to timestamps
+        CHECK(stats[4].type == ColumnType::TIMESTAMP);
+        CHECK(format_time(stats[4].min_time, true) == "2021-02-28 00:00:00");
+        CHECK(format_time(stats[4].max_time, true) == "2021-03-01 12:30:00");
+
+        // mixed columns keep the numeric stats gathered so far
+        CHECK(stats[5].type == ColumnType::STRING);
+        CHECK(stats[5].has_numeric_rows);
+        CHECK(stats[5].avg == 8);
+        CHECK(stats[5].float_frac == doctest::Approx((double)2 / 3).epsilon(0.01));
+
+        CHECK(stats[6].type == ColumnType::INT);
+        CHECK(stats[6].null_frac == doctest::Approx((double)2 / 3).epsilon(0.01));
+        CHECK(stats[6].float_frac == doctest::Approx((double)1 / 3).epsilon(0.01));
+
+        // hex numbers and a leading plus are not numeric
+        CHECK(stats[7].type == ColumnType::STRING);
+        CHECK(!stats[7].has_numeric_rows);
+        CHECK(stats[8].type == ColumnType::STRING);
+        CHECK(stats[8].float_frac == doctest::Approx((double)1 / 3).epsilon(0.01));
+
+        // ints beyond 2^53 keep their exact min and max
+        CHECK(stats[9].type == ColumnType::INT);
+        CHECK(stats[9].int_min == -9007199254740993LL);
+        CHECK(stats[9].int_max == 9007199254740993LL);
+    }
 }
\ No newline at end of file
@@ -2,4 +2,6 @@
 #include "doctest.h"
 
 #include "unittest_full_pass.h"
-#include "unittest_sample.h"
\ No newline at end of file
+#include "unittest_follow.h"
+#include "unittest_sample.h"
+#include "unittest_adaptive.h"
\ No newline at end of file
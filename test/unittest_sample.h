@@ -19,4 +19,90 @@ TEST_SUITE("csvsum_sample")
 
         check_simple_no_quote(col_names, no_rows, stats);
     }
+
+    TEST_CASE("reproducible_threads")
+    {
+        std::string path = (std::filesystem::temp_directory_path() / "csvsum_sample.csv").string();
+        std::ofstream out(path, std::ios::trunc);
+        out << "letter,value\n";
+        for (int i = 0; i < 10000; i++)
+        {
+            out << std::string(1 + i % 7, 'A') << "," << i << "\n";
+        }
+        out.close();
+
+        vector<std::string> col_names_single, col_names_multi;
+        long long no_rows_single, no_rows_multi;
+        std::unique_ptr<csvsum::SampleCSVSummarizer> single_sum(new csvsum::SampleCSVSummarizer(path, true, ',', '\n', '\\', 3, 1000, 100, 42, 1));
+        std::unique_ptr<csvsum::SampleCSVSummarizer> multi_sum(new csvsum::SampleCSVSummarizer(path, true, ',', '\n', '\\', 3, 1000, 100, 42, 4));
+
+        vector<CellStats> stats_single = single_sum->obtain_stats(false, col_names_single, no_rows_single);
+        vector<CellStats> stats_multi = multi_sum->obtain_stats(false, col_names_multi, no_rows_multi);
+
+        CHECK(no_rows_single == no_rows_multi);
+        CHECK(stats_single.size() == 2);
+        CHECK(stats_multi.size() == 2);
+        for (size_t i = 0; i < stats_single.size(); i++)
+        {
+            CHECK(stats_single[i].no_distinct_vals == stats_multi[i].no_distinct_vals);
+            CHECK(stats_single[i].avg == stats_multi[i].avg);
+            CHECK(stats_single[i].min == stats_multi[i].min);
+            CHECK(stats_single[i].max == stats_multi[i].max);
+            CHECK(stats_single[i].most_frequent == stats_multi[i].most_frequent);
+        }
+
+        std::filesystem::remove(path);
+    }
+
+    TEST_CASE("changed_file")
+    {
+        std::string path = (std::filesystem::temp_directory_path() / "csvsum_sample_changed.csv").string();
+        std::ofstream out(path, std::ios::trunc);
+        out << "letter\n";
+        for (int i = 0; i < 1000; i++)
+        {
+            out << "x\n";
+        }
+        out.close();
+
+        vector<std::string> col_names;
+        long long no_rows;
+        std::unique_ptr<csvsum::SampleCSVSummarizer> sample_sum(new csvsum::SampleCSVSummarizer(path, true, ',', '\n', '\\', 3, 1000, 100, 42, 1));
+        vector<CellStats> stats = sample_sum->obtain_stats(false, col_names, no_rows);
+        CHECK(stats[0].most_frequent[0] == "x");
+
+        // rows of the previous sample must not be reused
+        out.open(path, std::ios::trunc);
+        out << "letter\n";
+        for (int i = 0; i < 2000; i++)
+        {
+            out << "y\n";
+        }
+        out.close();
+        stats = sample_sum->obtain_stats(false, col_names, no_rows);
+        CHECK(stats[0].no_distinct_vals == 1);
+        CHECK(stats[0].most_frequent[0] == "y");
+
+        std::filesystem::remove(path);
+    }
+
+    TEST_CASE("unterminated_last_row")
+    {
+        // both rows are equally likely after weighting by their size in the file, the last row has no line break
+        std::string path = (std::filesystem::temp_directory_path() / "csvsum_unterminated.csv").string();
+        std::ofstream out(path, std::ios::trunc);
+        out << "k,v\na,1\nb,2";
+        out.close();
+
+        vector<std::string> col_names;
+        long long no_rows;
+        std::unique_ptr<csvsum::SampleCSVSummarizer> sample_sum(new csvsum::SampleCSVSummarizer(path, true, ',', '\n', '\\', 3, 20000, 100, 42, 1));
+        vector<CellStats> stats = sample_sum->obtain_stats(false, col_names, no_rows);
+
+        CHECK(no_rows == 2);
+        CHECK(stats.size() == 2);
+        CHECK(stats[1].avg == doctest::Approx(1.5).epsilon(0.01));
+
+        std::filesystem::remove(path);
+    }
 }
\ No newline at end of file